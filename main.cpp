@@ -33,17 +33,82 @@
 const unsigned int NUM_ROWS = 256;
 const unsigned int NUM_COLS = NUM_ROWS;
 const unsigned long NUM_PIXELS = NUM_COLS * NUM_ROWS;
+const unsigned int NUM_SLICES = 16; // depth of the test volume of the 3D DWT check
 const float SQRT_2 = 1.414214f;
 //const double SQRT_2 = 1.414213562373095;
+// subband orientations: LL is the top-left (approximation) subband, HL the top-right,
+// LH the bottom-left and HH the bottom-right subband of each level in the Mallat layout
+const unsigned char SUBBAND_LL = 0;
+const unsigned char SUBBAND_HL = 1;
+const unsigned char SUBBAND_LH = 2;
+const unsigned char SUBBAND_HH = 3;
+const unsigned int SUBBAND_ALIGNMENT = 16; // byte alignment of each subband in the packed layout (the packed buffer itself must start on this boundary)
+
+// describes where one subband lives in both the Mallat layout and the packed layout
+typedef struct
+{
+    unsigned short level; // decomposition level, 1 is the finest
+    unsigned char orientation; // SUBBAND_LL, SUBBAND_HL, SUBBAND_LH or SUBBAND_HH
+    unsigned int rowStart; // first row of the subband in the Mallat layout
+    unsigned int colStart; // first column of the subband in the Mallat layout
+    unsigned int rowLen; // number of rows in the subband
+    unsigned int colLen; // number of columns in the subband
+    unsigned long offset; // offset of the subband's first element in the packed buffer
+} SubbandDescriptor;
+
+// depth-wise re-arrangement modes of the 3D DWT and IDWT
+const unsigned char REARRANGE_IN_PLACE = 0; // one z-pencil at a time with rearrange2DFromTC(): no scratch array, but strided by a whole slice
+const unsigned char REARRANGE_TILED = 1; // a tile of up to Z_TILE_LEN values of each slice at a time, through a Z_TILE_LEN-byte scratch array
+const unsigned int Z_TILE_LEN = 4096; // size of the scratch tile of REARRANGE_TILED
+
+const unsigned int NUM_HIST_BINS = 16; // coarse histogram of the coefficient values
+const unsigned int HIST_BIN_SHIFT = 4; // value >> HIST_BIN_SHIFT is the histogram bin of a coefficient value
+
+// statistics of one subband. They are taken over the 8-bit values stored in arr, ie the
+// coefficients modulo 256: a negative fluctuation such as -1 is stored, and counted, as 255,
+// so for the detail subbands the energy, mean and variance are not those of the signed coefficients
+typedef struct
+{
+    unsigned long count; // number of coefficients
+    unsigned long sum; // sum of the coefficients
+    double sumSq; // sum of the squared coefficients (energy); double since 255*255*count overflows 32 bits
+    unsigned char min; // smallest coefficient
+    unsigned char max; // largest coefficient
+    unsigned long nonZero; // number of non-zero coefficients
+    unsigned long histogram[NUM_HIST_BINS]; // bin b counts the coefficients whose value >> HIST_BIN_SHIFT is b
+} SubbandStats;
 
 unsigned char validateLength(unsigned short* pI, unsigned int length);
 unsigned short inputAndValidation(unsigned short* pI);
 void waveletTransform2D(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned short level);
+void dwtLevel2D(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned int decimatingRowLen, unsigned int decimatingColLen);
 void rearrange2DFromLR(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned int decimatingColLen, unsigned int decimatingRowIndex);// decimatingRowIndex is zero-based row index
 void revertRearrange2DFromLR(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned int runningColLen, unsigned int runningRowIndex);// runningRowIndex is zero-based row index
 void rearrange2DFromTC(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned int decimatingRowLen, unsigned int decimatingColumnIndex);// decimatingColumnIndex is zero-based column index
 void revertRearrange2DFromTC(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned int runningRowLen, unsigned int runningColumnIndex); // runningColumnIndex is zero-based column index
 void invWaveletTransform2D(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned short level);
+void idwtLevel2D(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned int runningRowLen, unsigned int runningColLen);
+unsigned long crtSubbandTable(SubbandDescriptor* table, unsigned int rowLen, unsigned int colLen, unsigned short level, unsigned int alignment);// table must hold 3*level + 1 descriptors
+unsigned int subbandIndex(unsigned short level, unsigned short k, unsigned char orientation);
+void copyToSubband(const unsigned char* arr, unsigned int colLen, unsigned char* packed, const SubbandDescriptor* desc);
+void copyFromSubband(unsigned char* arr, unsigned int colLen, const unsigned char* packed, const SubbandDescriptor* desc);
+void packSubbands(const unsigned char* arr, unsigned int colLen, unsigned char* packed, const SubbandDescriptor* table, unsigned short level);
+void unpackSubbands(unsigned char* arr, unsigned int colLen, const unsigned char* packed, const SubbandDescriptor* table, unsigned short level);
+void waveletTransform2DPacked(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned short level, unsigned char* packed, const SubbandDescriptor* table);
+void invWaveletTransform2DPacked(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned short level, const unsigned char* packed, const SubbandDescriptor* table);
+unsigned char* alignSubbandBuffer(unsigned char* raw);// raw must hold SUBBAND_ALIGNMENT - 1 bytes more than the packed buffer
+unsigned long checkPackedRoundTrip(const unsigned char* image, unsigned int rowLen, unsigned int colLen, unsigned short level);
+void waveletTransform2DStats(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned short level, SubbandStats* stats);// stats must hold 3*level + 1 entries, indexed as by subbandIndex()
+void resetSubbandStats(SubbandStats* stats);
+void accumulateSubbandStats(SubbandStats* stats, const unsigned char* arr, unsigned int colLen, unsigned int rowStart, unsigned int colStart, unsigned int subRowLen, unsigned int subColLen);
+double subbandMean(const SubbandStats* stats);
+double subbandVariance(const SubbandStats* stats);
+void printSubbandStats(const SubbandStats* stats, unsigned short level);
+void waveletTransform3D(unsigned char* arr, unsigned int depthLen, unsigned int rowLen, unsigned int colLen, unsigned short level, unsigned char rearrangeMode);// rearrangeMode is REARRANGE_IN_PLACE or REARRANGE_TILED
+void invWaveletTransform3D(unsigned char* arr, unsigned int depthLen, unsigned int rowLen, unsigned int colLen, unsigned short level, unsigned char rearrangeMode);
+void rearrange3DFromFB(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned int decimatingDepthLen, unsigned int decimatingRowLen, unsigned int decimatingColLen);
+void revertRearrange3DFromFB(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned int runningDepthLen, unsigned int runningRowLen, unsigned int runningColLen);
+unsigned long checkTransform3D(const unsigned char* image, unsigned int rowLen, unsigned int colLen, unsigned int depthLen, unsigned short level);
 unsigned int twoExpLevel(unsigned short iLevel);
 void crtFlatArr(unsigned char* const pUch, const cv::Mat myImage);
 void crtMatArr(unsigned char* const pUch, cv::Mat & myImage);
@@ -80,6 +145,27 @@ int main()
     // OR 
     //b) Manually assign iMaxLevel if you do not want to input data in the command prompt
     iMaxLevel = 6;
+    
+    // check the packed (subband-contiguous) layout against the in-place DWT and IDWT
+    unsigned long packedMismatches = checkPackedRoundTrip(testArr2D[0], NUM_ROWS, NUM_COLS, iMaxLevel);
+    std::cout << "Packed layout round trip: " << packedMismatches << " mismatches" << std::endl << std::endl;
+    
+    // statistics of every subband, computed along with the DWT of a copy of the image
+    unsigned char statsArr2D[NUM_ROWS][NUM_COLS];
+    for(unsigned long n = 0; n < NUM_PIXELS; n++)
+    {
+        *(statsArr2D[0] + n) = *(testArr2D[0] + n);
+    }// end for
+    SubbandStats* pSubbandStats = new SubbandStats[3u*iMaxLevel + 1];
+    waveletTransform2DStats(statsArr2D[0], NUM_ROWS, NUM_COLS, iMaxLevel, pSubbandStats);
+    printSubbandStats(pSubbandStats, iMaxLevel);
+    delete [] pSubbandStats;
+    
+    // check the tiled depth-wise re-arrangement of the 3D DWT and IDWT against the in-place one
+    unsigned short iMaxLevel3D;
+    if(validateLength(&iMaxLevel3D, NUM_SLICES) <= 0) return 1;
+    unsigned long mismatches3D = checkTransform3D(testArr2D[0], NUM_ROWS, NUM_COLS, NUM_SLICES, iMaxLevel3D);
+    std::cout << "3D tiled vs in-place re-arrangement: " << mismatches3D << " mismatches" << std::endl << std::endl;
    
     // Perform 2D Haar DWT
     waveletTransform2D(testArr2D[0], NUM_ROWS, NUM_COLS, iMaxLevel);
@@ -127,42 +213,48 @@ void waveletTransform2D(unsigned char* arr, unsigned int rowLen, unsigned int co
     
     while(level--)
     {
-        //1) Perform 1D DWT row-wise, left to right
-        for(unsigned int i = 0; i < decimatingRowLen; i++) //row indices for-loop
-        {
-            // INSTEAD USE MAPPED EQUIVALENT INDICES ONLY WHILE ASSIGNING VALUES
-            unsigned char iTemp01, iTemp02;
-            for(unsigned int j = 0; j < decimatingColLen; j+=2) // only even column indices
-            {
-                int n = i*colLen + j; // nth index (flattened) in a 2D array in the direction from left to right row-wise
-                int v = 1; // the index offset in a 2D array in the direction from left to right row-wise
-                iTemp01 = *(arr + n); iTemp02 = *(arr + n + v);
-                *(arr + n) = (int)(((iTemp01 + iTemp02)/SQRT_2) + 0.5); // calculate trend to the nearest int
-                *(arr + n + v) = (int)(((iTemp01 - iTemp02)/SQRT_2) + 0.5); // calculate fluctuation to the nearest int
-            }// //end column indices for-loop
-            rearrange2DFromLR(arr, rowLen, colLen, decimatingColLen, i);
-        }// //end row indices for-loop 
-
-        //2) Then, perform 1D DWT column-wise, top to bottom
-        for(unsigned int j = 0; j < decimatingColLen; j++) //column indices for-loop
-        {
-            // INSTEAD USE MAPPED EQUIVALENT INDICES ONLY WHILE ASSIGNING VALUES
-            unsigned char iTemp01, iTemp02;
-            for(unsigned int i = 0; i < decimatingRowLen; i+=2) // only even row indices
-            {
-                int n = j + i*colLen; // nth index (flattened) in a 2D array in the direction from top to bottom column-wise
-                int v = colLen; // the index offset in a 2D array in the direction from top to bottom column-wise
-                iTemp01 = *(arr + n); iTemp02 = *(arr + n + v);
-                *(arr + n) = (int)(((iTemp01 + iTemp02)/SQRT_2) + 0.5); // calculate trend to the nearest int
-                *(arr + n + v) = (int)(((iTemp01 - iTemp02)/SQRT_2) + 0.5); // calculate fluctuation to the nearest int
-            }// //end row indices for-loop
-            rearrange2DFromTC(arr, rowLen, colLen,decimatingRowLen, j);
-        }//end column indices for-loop 
+        dwtLevel2D(arr, rowLen, colLen, decimatingRowLen, decimatingColLen);
         decimatingColLen /= 2; //OR: decimatingColLen >>= 1;
         decimatingRowLen /= 2; //OR: decimatingRowLen >>= 1;
     }// end while-loop
 }// waveletTransform2D()
 
+// one level of the 2D DWT over the top-left decimatingRowLen x decimatingColLen region of arr
+void dwtLevel2D(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned int decimatingRowLen, unsigned int decimatingColLen)
+{
+    //1) Perform 1D DWT row-wise, left to right
+    for(unsigned int i = 0; i < decimatingRowLen; i++) //row indices for-loop
+    {
+        // INSTEAD USE MAPPED EQUIVALENT INDICES ONLY WHILE ASSIGNING VALUES
+        unsigned char iTemp01, iTemp02;
+        for(unsigned int j = 0; j < decimatingColLen; j+=2) // only even column indices
+        {
+            int n = i*colLen + j; // nth index (flattened) in a 2D array in the direction from left to right row-wise
+            int v = 1; // the index offset in a 2D array in the direction from left to right row-wise
+            iTemp01 = *(arr + n); iTemp02 = *(arr + n + v);
+            *(arr + n) = (int)(((iTemp01 + iTemp02)/SQRT_2) + 0.5); // calculate trend to the nearest int
+            *(arr + n + v) = (int)(((iTemp01 - iTemp02)/SQRT_2) + 0.5); // calculate fluctuation to the nearest int
+        }// //end column indices for-loop
+        rearrange2DFromLR(arr, rowLen, colLen, decimatingColLen, i);
+    }// //end row indices for-loop 
+
+    //2) Then, perform 1D DWT column-wise, top to bottom
+    for(unsigned int j = 0; j < decimatingColLen; j++) //column indices for-loop
+    {
+        // INSTEAD USE MAPPED EQUIVALENT INDICES ONLY WHILE ASSIGNING VALUES
+        unsigned char iTemp01, iTemp02;
+        for(unsigned int i = 0; i < decimatingRowLen; i+=2) // only even row indices
+        {
+            int n = j + i*colLen; // nth index (flattened) in a 2D array in the direction from top to bottom column-wise
+            int v = colLen; // the index offset in a 2D array in the direction from top to bottom column-wise
+            iTemp01 = *(arr + n); iTemp02 = *(arr + n + v);
+            *(arr + n) = (int)(((iTemp01 + iTemp02)/SQRT_2) + 0.5); // calculate trend to the nearest int
+            *(arr + n + v) = (int)(((iTemp01 - iTemp02)/SQRT_2) + 0.5); // calculate fluctuation to the nearest int
+        }// //end row indices for-loop
+        rearrange2DFromTC(arr, rowLen, colLen,decimatingRowLen, j);
+    }//end column indices for-loop 
+}// end dwtLevel2D()
+
 void invWaveletTransform2D(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned short level)
 {
     std::cout << "This is level " << level << " IDWT Computation." << std::endl << std::endl;
@@ -175,41 +267,680 @@ void invWaveletTransform2D(unsigned char* arr, unsigned int rowLen, unsigned int
 
     while(level--)
     {
-        //1) Perform 1D IDWT column-wise, top to bottom
-        for(unsigned int j = 0; j < runningColLen; j++) //column indices for-loop
+        idwtLevel2D(arr, rowLen, colLen, runningRowLen, runningColLen);
+        runningRowLen *=2; // OR: runningRowLen <<= 1;
+        runningColLen *=2; // OR: runningColLen <<= 1;
+    }// end while-loop
+}// end invWaveletTransform2D()
+
+// one level of the 2D IDWT over the top-left runningRowLen x runningColLen region of arr
+void idwtLevel2D(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned int runningRowLen, unsigned int runningColLen)
+{
+    //1) Perform 1D IDWT column-wise, top to bottom
+    for(unsigned int j = 0; j < runningColLen; j++) //column indices for-loop
+    {
+        // INSTEAD USE MAPPED EQUIVALENT INDICES ONLY WHILE ASSIGNING VALUES
+        revertRearrange2DFromTC(arr, rowLen, colLen, runningRowLen, j);
+        unsigned char iTemp01, iTemp02;
+        for(unsigned int i = 0; i < runningRowLen; i+=2) // only even row indices
+        {
+                int n = j + i*colLen; // nth index (flattened) in a 2D array in the direction from top to bottom column-wise
+                int v = colLen; // the index offset in a 2D array in the direction from top to bottom column-wise
+                iTemp01 = *(arr + n); iTemp02 = *(arr + n + v);
+                *(arr + n) = (int)(((iTemp01 + iTemp02)/SQRT_2) + 0.5); // calculate sample to the nearest int
+                *(arr + n + v) = (int)(((iTemp01 - iTemp02)/SQRT_2) + 0.5); // calculate next sample to the nearest int
+        } //end row indices for-loop  
+    } //end column indices for-loop  
+
+    //2) Then, perform 1D IDWT row-wise, left to right
+    for(unsigned int i = 0; i < runningRowLen; i++) //row indices for-loop
+    {
+        // INSTEAD USE MAPPED EQUIVALENT INDICES ONLY WHILE ASSIGNING VALUES
+        revertRearrange2DFromLR(arr, rowLen, colLen, runningColLen, i);
+        unsigned char iTemp01, iTemp02;
+        for(unsigned int j = 0; j < runningColLen; j+=2) // only even column indices
+        {
+                int n = i*colLen + j; // nth index (flattened) in a 2D array in the direction from left to right row-wise
+                int v = 1; // the index offset in a 2D array in the direction from left to right row-wise
+                iTemp01 = *(arr + n); iTemp02 = *(arr + n + v);
+                *(arr + n) = (int)(((iTemp01 + iTemp02)/SQRT_2) + 0.5); // calculate sample to the nearest int
+                *(arr + n + v) = (int)(((iTemp01 - iTemp02)/SQRT_2) + 0.5); // calculate next sample to the nearest int
+        }// //end column indices for-loop
+    }//end row indices for-loop
+}// end idwtLevel2D()
+
+// fill table with the 3*level + 1 subband descriptors in coarsest-first order
+// (LL, then HL, LH, HH from the coarsest level down to level 1) and return the
+// length of the packed buffer; every subband offset is rounded up to a multiple of alignment.
+// The offsets are relative to the start of the packed buffer, so the subbands are only aligned
+// if the caller allocates that buffer on an alignment boundary (see alignSubbandBuffer())
+unsigned long crtSubbandTable(SubbandDescriptor* table, unsigned int rowLen, unsigned int colLen, unsigned short level, unsigned int alignment)
+{
+    unsigned long offset = 0;
+    unsigned int n = 0; // table index
+    
+    if(alignment == 0) alignment = 1; // no padding between subbands
+    
+    // the approximation (LL) subband of the coarsest level
+    table[n].level = level;
+    table[n].orientation = SUBBAND_LL;
+    table[n].rowStart = 0;
+    table[n].colStart = 0;
+    table[n].rowLen = rowLen >> level;
+    table[n].colLen = colLen >> level;
+    table[n].offset = 0;
+    offset = (unsigned long)table[n].rowLen * table[n].colLen;
+    n++;
+    
+    // the detail subbands of every level, coarsest first
+    for(unsigned short k = level; k >= 1; k--)
+    {
+        unsigned int h = rowLen >> k; // subband row length at level k
+        unsigned int w = colLen >> k; // subband column length at level k
+        for(unsigned char orientation = SUBBAND_HL; orientation <= SUBBAND_HH; orientation++)
+        {
+            offset = ((offset + alignment - 1)/alignment)*alignment; // round up to the next aligned offset
+            table[n].level = k;
+            table[n].orientation = orientation;
+            table[n].rowStart = (orientation == SUBBAND_HL) ? 0 : h; // LH and HH are in the bottom half
+            table[n].colStart = (orientation == SUBBAND_LH) ? 0 : w; // HL and HH are in the right half
+            table[n].rowLen = h;
+            table[n].colLen = w;
+            table[n].offset = offset;
+            offset += (unsigned long)h * w;
+            n++;
+        }// end orientation for-loop
+    }// end level for-loop
+    return offset;
+}// end crtSubbandTable()
+
+// index into the subband table of the subband with the given orientation at level k (1 is the finest level)
+unsigned int subbandIndex(unsigned short level, unsigned short k, unsigned char orientation)
+{
+    if(orientation == SUBBAND_LL) return 0;
+    return 1 + 3*(level - k) + (orientation - SUBBAND_HL);
+}// end subbandIndex()
+
+// copy one subband from its rectangle in the Mallat (in-place) layout to its contiguous block in packed
+void copyToSubband(const unsigned char* arr, unsigned int colLen, unsigned char* packed, const SubbandDescriptor* desc)
+{
+    unsigned char* pDst = packed + desc->offset;
+    for(unsigned int i = 0; i < desc->rowLen; i++) //row indices for-loop
+    {
+        const unsigned char* pSrc = arr + (desc->rowStart + i)*colLen + desc->colStart;
+        for(unsigned int j = 0; j < desc->colLen; j++) // column indices for-loop
+        {
+            *(pDst++) = *(pSrc + j);
+        }// end column indices for-loop
+    }// end row indices for-loop
+}// end copyToSubband()
+
+// copy one subband from its contiguous block in packed back to its rectangle in the Mallat (in-place) layout
+void copyFromSubband(unsigned char* arr, unsigned int colLen, const unsigned char* packed, const SubbandDescriptor* desc)
+{
+    const unsigned char* pSrc = packed + desc->offset;
+    for(unsigned int i = 0; i < desc->rowLen; i++) //row indices for-loop
+    {
+        unsigned char* pDst = arr + (desc->rowStart + i)*colLen + desc->colStart;
+        for(unsigned int j = 0; j < desc->colLen; j++) // column indices for-loop
+        {
+            *(pDst + j) = *(pSrc++);
+        }// end column indices for-loop
+    }// end row indices for-loop
+}// end copyFromSubband()
+
+// convert a complete Mallat-layout DWT array into the packed layout described by table
+void packSubbands(const unsigned char* arr, unsigned int colLen, unsigned char* packed, const SubbandDescriptor* table, unsigned short level)
+{
+    for(unsigned int n = 0; n < 3u*level + 1; n++)
+    {
+        copyToSubband(arr, colLen, packed, table + n);
+    }// end for
+}// end packSubbands()
+
+// convert a packed-layout DWT buffer back into the Mallat layout
+void unpackSubbands(unsigned char* arr, unsigned int colLen, const unsigned char* packed, const SubbandDescriptor* table, unsigned short level)
+{
+    for(unsigned int n = 0; n < 3u*level + 1; n++)
+    {
+        copyFromSubband(arr, colLen, packed, table + n);
+    }// end for
+}// end unpackSubbands()
+
+// 2D DWT whose output is written in the packed layout described by table (see crtSubbandTable()):
+// the detail subbands of each level are copied out right after that level is computed, and the
+// LL subband after the last level. arr is used as the working array and is left in Mallat layout
+void waveletTransform2DPacked(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned short level, unsigned char* packed, const SubbandDescriptor* table)
+{
+    std::cout << "This is level " << level << " 2D DWT Computation (Packed Output)." << std::endl << std::endl;
+    unsigned int decimatingRowLen, decimatingColLen;
+    unsigned short maxLevel = level;
+    unsigned short k = 1; // level just computed, 1 is the finest level
+    
+    decimatingColLen = colLen; // initial decimating column length deduced
+    decimatingRowLen = rowLen; // initial decimating row length deduced
+    
+    while(level--)
+    {
+        dwtLevel2D(arr, rowLen, colLen, decimatingRowLen, decimatingColLen);
+        for(unsigned char orientation = SUBBAND_HL; orientation <= SUBBAND_HH; orientation++)
+        {
+            copyToSubband(arr, colLen, packed, table + subbandIndex(maxLevel, k, orientation));
+        }// end for
+        decimatingColLen /= 2; //OR: decimatingColLen >>= 1;
+        decimatingRowLen /= 2; //OR: decimatingRowLen >>= 1;
+        k++;
+    }// end while-loop
+    copyToSubband(arr, colLen, packed, table + subbandIndex(maxLevel, maxLevel, SUBBAND_LL));
+}// end waveletTransform2DPacked()
+
+// 2D IDWT whose input is in the packed layout described by table: the LL subband and the detail
+// subbands of each level are copied into arr just before that level is inverted. The reconstructed
+// image is left in arr
+void invWaveletTransform2DPacked(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned short level, const unsigned char* packed, const SubbandDescriptor* table)
+{
+    std::cout << "This is level " << level << " IDWT Computation (Packed Input)." << std::endl << std::endl;
+    unsigned int runningRowLen, runningColLen; 
+    unsigned short maxLevel = level;
+    unsigned short k = level; // level to be inverted next, 1 is the finest level
+    
+    runningRowLen = 2*rowLen/(1 << level); // initial row running length deduced
+    runningColLen = 2*colLen/(1 << level); // initial column running length deduced
+    
+    copyFromSubband(arr, colLen, packed, table + subbandIndex(maxLevel, maxLevel, SUBBAND_LL));
+    while(level--)
+    {
+        for(unsigned char orientation = SUBBAND_HL; orientation <= SUBBAND_HH; orientation++)
+        {
+            copyFromSubband(arr, colLen, packed, table + subbandIndex(maxLevel, k, orientation));
+        }// end for
+        idwtLevel2D(arr, rowLen, colLen, runningRowLen, runningColLen);
+        runningRowLen *=2; // OR: runningRowLen <<= 1;
+        runningColLen *=2; // OR: runningColLen <<= 1;
+        k--;
+    }// end while-loop
+}// end invWaveletTransform2DPacked()
+
+// first SUBBAND_ALIGNMENT-aligned address within raw, for use as the packed buffer
+unsigned char* alignSubbandBuffer(unsigned char* raw)
+{
+    size_t misalignment = (size_t)raw % SUBBAND_ALIGNMENT;
+    return (misalignment == 0) ? raw : raw + (SUBBAND_ALIGNMENT - misalignment);
+}// end alignSubbandBuffer()
+
+// round trip of image through the packed layout: the packed DWT must equal packSubbands() of the
+// in-place DWT, and the packed IDWT must equal the in-place IDWT. Returns the number of mismatching values
+unsigned long checkPackedRoundTrip(const unsigned char* image, unsigned int rowLen, unsigned int colLen, unsigned short level)
+{
+    unsigned long len = (unsigned long)rowLen*colLen;
+    unsigned long mismatches = 0;
+    unsigned char* arrInPlace = new unsigned char[len];
+    unsigned char* arrPacked = new unsigned char[len];
+    SubbandDescriptor* table = new SubbandDescriptor[3u*level + 1];
+    unsigned long packedLen = crtSubbandTable(table, rowLen, colLen, level, SUBBAND_ALIGNMENT);
+    unsigned char* packedInPlaceRaw = new unsigned char[packedLen + SUBBAND_ALIGNMENT - 1];
+    unsigned char* packedRaw = new unsigned char[packedLen + SUBBAND_ALIGNMENT - 1];
+    unsigned char* packedInPlace = alignSubbandBuffer(packedInPlaceRaw);
+    unsigned char* packed = alignSubbandBuffer(packedRaw);
+    
+    for(unsigned long n = 0; n < len; n++)
+    {
+        *(arrInPlace + n) = *(image + n);
+        *(arrPacked + n) = *(image + n);
+    }// end for
+    for(unsigned long n = 0; n < packedLen; n++) // the padding between subbands is never written
+    {
+        *(packedInPlace + n) = 0;
+        *(packed + n) = 0;
+    }// end for
+    
+    waveletTransform2D(arrInPlace, rowLen, colLen, level);
+    packSubbands(arrInPlace, colLen, packedInPlace, table, level);
+    waveletTransform2DPacked(arrPacked, rowLen, colLen, level, packed, table);
+    for(unsigned long n = 0; n < packedLen; n++)
+    {
+        mismatches += (*(packedInPlace + n) != *(packed + n));
+    }// end for
+    
+    invWaveletTransform2D(arrInPlace, rowLen, colLen, level);
+    for(unsigned long n = 0; n < len; n++)
+    {
+        *(arrPacked + n) = 0; // the packed IDWT must not depend on what is left in arr
+    }// end for
+    invWaveletTransform2DPacked(arrPacked, rowLen, colLen, level, packed, table);
+    for(unsigned long n = 0; n < len; n++)
+    {
+        mismatches += (*(arrInPlace + n) != *(arrPacked + n));
+    }// end for
+    
+    delete [] packedRaw;
+    delete [] packedInPlaceRaw;
+    delete [] table;
+    delete [] arrPacked;
+    delete [] arrInPlace;
+    return mismatches;
+}// end checkPackedRoundTrip()
+
+// 2D DWT that also fills stats with the statistics of every subband (indexed as by subbandIndex()).
+// Each level's detail subbands are added to stats as soon as dwtLevel2D() returns for that level
+// (LL after the last level) rather than in a separate pass once the whole DWT is done
+void waveletTransform2DStats(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned short level, SubbandStats* stats)
+{
+    std::cout << "This is level " << level << " 2D DWT Computation (With Statistics)." << std::endl << std::endl;
+    unsigned int decimatingRowLen, decimatingColLen;
+    unsigned short maxLevel = level;
+    unsigned short k = 1; // level being computed, 1 is the finest level
+    
+    for(unsigned int n = 0; n < 3u*maxLevel + 1; n++)
+    {
+        resetSubbandStats(stats + n);
+    }// end for
+    
+    decimatingColLen = colLen; // initial decimating column length deduced
+    decimatingRowLen = rowLen; // initial decimating row length deduced
+    
+    while(level--)
+    {
+        dwtLevel2D(arr, rowLen, colLen, decimatingRowLen, decimatingColLen);
+        decimatingColLen /= 2; //OR: decimatingColLen >>= 1;
+        decimatingRowLen /= 2; //OR: decimatingRowLen >>= 1;
+        // HL is top-right, LH bottom-left and HH bottom-right of the region just transformed
+        accumulateSubbandStats(stats + subbandIndex(maxLevel, k, SUBBAND_HL), arr, colLen, 0, decimatingColLen, decimatingRowLen, decimatingColLen);
+        accumulateSubbandStats(stats + subbandIndex(maxLevel, k, SUBBAND_LH), arr, colLen, decimatingRowLen, 0, decimatingRowLen, decimatingColLen);
+        accumulateSubbandStats(stats + subbandIndex(maxLevel, k, SUBBAND_HH), arr, colLen, decimatingRowLen, decimatingColLen, decimatingRowLen, decimatingColLen);
+        k++;
+    }// end while-loop
+    accumulateSubbandStats(stats + subbandIndex(maxLevel, maxLevel, SUBBAND_LL), arr, colLen, 0, 0, decimatingRowLen, decimatingColLen);
+}// end waveletTransform2DStats()
+
+void resetSubbandStats(SubbandStats* stats)
+{
+    stats->count = 0;
+    stats->sum = 0;
+    stats->sumSq = 0.0;
+    stats->min = 255;
+    stats->max = 0;
+    stats->nonZero = 0;
+    for(unsigned int b = 0; b < NUM_HIST_BINS; b++)
+    {
+        stats->histogram[b] = 0;
+    }// end for
+}// end resetSubbandStats()
+
+// add the subRowLen x subColLen rectangle of arr starting at (rowStart, colStart) to stats, row by row.
+// Sum, sum of squares, non-zero count, min and max are taken in one loop free of memory dependencies
+// so that the compiler can vectorize it; the histogram, whose increments can collide, is counted in
+// a loop of its own into a local histogram that is added to stats once
+void accumulateSubbandStats(SubbandStats* stats, const unsigned char* arr, unsigned int colLen, unsigned int rowStart, unsigned int colStart, unsigned int subRowLen, unsigned int subColLen)
+{
+    const unsigned int MAX_RUN_LEN = 65536; // a run of 255s this long still fits runSumSq in 32 bits
+    unsigned char minValue = stats->min, maxValue = stats->max;
+    unsigned long hist[NUM_HIST_BINS];
+    for(unsigned int b = 0; b < NUM_HIST_BINS; b++)
+    {
+        hist[b] = 0;
+    }// end for
+    
+    for(unsigned int i = 0; i < subRowLen; i++) //row indices for-loop
+    {
+        const unsigned char* pRow = arr + (unsigned long)(rowStart + i)*colLen + colStart;
+        for(unsigned int j0 = 0; j0 < subColLen; j0 += MAX_RUN_LEN) // runs of the row, one in practice
+        {
+            unsigned int runLen = ((subColLen - j0) < MAX_RUN_LEN) ? (subColLen - j0) : MAX_RUN_LEN;
+            unsigned int runSum = 0, runSumSq = 0, runNonZero = 0;
+            for(unsigned int j = 0; j < runLen; j++) // column indices for-loop
+            {
+                unsigned char value = *(pRow + j0 + j);
+                runSum += value;
+                runSumSq += (unsigned int)value*value;
+                runNonZero += (value != 0);
+                minValue = (value < minValue) ? value : minValue;
+                maxValue = (value > maxValue) ? value : maxValue;
+            }// end column indices for-loop
+            stats->sum += runSum;
+            stats->sumSq += (double)runSumSq;
+            stats->nonZero += runNonZero;
+        }// end run for-loop
+        
+        for(unsigned int j = 0; j < subColLen; j++) // column indices for-loop
+        {
+            hist[*(pRow + j) >> HIST_BIN_SHIFT]++;
+        }// end column indices for-loop
+    }// end row indices for-loop
+    
+    stats->count += (unsigned long)subRowLen*subColLen;
+    stats->min = minValue;
+    stats->max = maxValue;
+    for(unsigned int b = 0; b < NUM_HIST_BINS; b++)
+    {
+        stats->histogram[b] += hist[b];
+    }// end for
+}// end accumulateSubbandStats()
+
+double subbandMean(const SubbandStats* stats)
+{
+    if(stats->count == 0) return 0.0;
+    return (double)stats->sum/stats->count;
+}// end subbandMean()
+
+double subbandVariance(const SubbandStats* stats)
+{
+    if(stats->count == 0) return 0.0;
+    double mean = subbandMean(stats);
+    return stats->sumSq/stats->count - mean*mean;
+}// end subbandVariance()
+
+void printSubbandStats(const SubbandStats* stats, unsigned short level)
+{
+    const char* names[4] = {"LL", "HL", "LH", "HH"}; // indexed by orientation
+    
+    for(unsigned int n = 0; n < 3u*level + 1; n++)
+    {
+        unsigned short k = (n == 0) ? level : level - (n - 1)/3; // level of the nth subband
+        unsigned char orientation = (n == 0) ? SUBBAND_LL : SUBBAND_HL + (n - 1)%3;
+        std::cout << names[orientation] << k << ": count = " << (stats + n)->count
+                << ", mean = " << subbandMean(stats + n) << ", variance = " << subbandVariance(stats + n)
+                << ", energy = " << (stats + n)->sumSq << ", min = " << static_cast<int>((stats + n)->min)
+                << ", max = " << static_cast<int>((stats + n)->max) << ", non-zero = " << (stats + n)->nonZero << std::endl;
+        std::cout << "    histogram:";
+        for(unsigned int b = 0; b < NUM_HIST_BINS; b++)
+        {
+            std::cout << " " << (stats + n)->histogram[b];
+        }// end for
+        std::cout << std::endl;
+    }// end for
+    std::cout << std::endl;
+}// end printSubbandStats()
+
+// 3D (volume or spatio-temporal) Haar DWT of depthLen slices of rowLen x colLen each, stored slice after slice.
+// Each level performs the 2D DWT on every slice and then the 1D DWT along z (depth-wise, front to back).
+// rearrangeMode selects how the slices are re-arranged depth-wise: REARRANGE_IN_PLACE keeps the
+// no-scratch-array design but walks each z-pencil with a stride of a whole slice, REARRANGE_TILED
+// moves contiguous tiles through a Z_TILE_LEN-byte scratch array and is much faster on large volumes.
+// Each slice is addressed with the int indices of the 2D routines, so a slice must hold fewer than
+// 2^31 values; REARRANGE_IN_PLACE also indexes the whole volume that way, so with it the volume must
+// too, while REARRANGE_TILED addresses the volume with unsigned long offsets
+void waveletTransform3D(unsigned char* arr, unsigned int depthLen, unsigned int rowLen, unsigned int colLen, unsigned short level, unsigned char rearrangeMode)
+{
+    std::cout << "This is level " << level << " 3D DWT Computation." << std::endl << std::endl;
+    unsigned int decimatingDepthLen, decimatingRowLen, decimatingColLen;
+    unsigned long sliceLen = (unsigned long)rowLen*colLen; // the index offset between slices
+    
+    decimatingDepthLen = depthLen; // initial decimating depth length deduced
+    decimatingRowLen = rowLen; // initial decimating row length deduced
+    decimatingColLen = colLen; // initial decimating column length deduced
+    
+    while(level--)
+    {
+        //1) Perform 2D DWT slice by slice
+        for(unsigned int z = 0; z < decimatingDepthLen; z++) //slice indices for-loop
+        {
+            dwtLevel2D(arr + z*sliceLen, rowLen, colLen, decimatingRowLen, decimatingColLen);
+        }// end slice indices for-loop
+        
+        //2) Then, perform 1D DWT depth-wise, front to back. The z-pencils are processed a pair of
+        // slices at a time with the column index innermost, so that both slices are read and
+        // written sequentially rather than one pencil at a time with a stride of sliceLen
+        for(unsigned int z = 0; z < decimatingDepthLen; z+=2) // only even slice indices
         {
-            // INSTEAD USE MAPPED EQUIVALENT INDICES ONLY WHILE ASSIGNING VALUES
-            revertRearrange2DFromTC(arr, rowLen, colLen, runningRowLen, j);
             unsigned char iTemp01, iTemp02;
-            for(unsigned int i = 0; i < runningRowLen; i+=2) // only even row indices
+            for(unsigned int i = 0; i < decimatingRowLen; i++) //row indices for-loop
             {
-                    int n = j + i*colLen; // nth index (flattened) in a 2D array in the direction from top to bottom column-wise
-                    int v = colLen; // the index offset in a 2D array in the direction from top to bottom column-wise
+                for(unsigned int j = 0; j < decimatingColLen; j++) //column indices for-loop
+                {
+                    unsigned long n = z*sliceLen + i*colLen + j; // nth index (flattened) in a 3D array in the direction from front to back depth-wise
+                    unsigned long v = sliceLen; // the index offset in a 3D array in the direction from front to back depth-wise
                     iTemp01 = *(arr + n); iTemp02 = *(arr + n + v);
-                    *(arr + n) = (int)(((iTemp01 + iTemp02)/SQRT_2) + 0.5); // calculate sample to the nearest int
-                    *(arr + n + v) = (int)(((iTemp01 - iTemp02)/SQRT_2) + 0.5); // calculate next sample to the nearest int
-            } //end row indices for-loop  
-        } //end column indices for-loop  
+                    *(arr + n) = (int)(((iTemp01 + iTemp02)/SQRT_2) + 0.5); // calculate trend to the nearest int
+                    *(arr + n + v) = (int)(((iTemp01 - iTemp02)/SQRT_2) + 0.5); // calculate fluctuation to the nearest int
+                }// end column indices for-loop
+            }// end row indices for-loop
+        }// end slice indices for-loop
+        
+        if(rearrangeMode == REARRANGE_TILED)
+        {
+            rearrange3DFromFB(arr, rowLen, colLen, decimatingDepthLen, decimatingRowLen, decimatingColLen);
+        }
+        else // REARRANGE_IN_PLACE: a z-pencil is a column whose column length is sliceLen
+        {
+            for(unsigned int i = 0; i < decimatingRowLen; i++) //row indices for-loop
+            {
+                for(unsigned int j = 0; j < decimatingColLen; j++) //column indices for-loop
+                {
+                    rearrange2DFromTC(arr, depthLen, (unsigned int)sliceLen, decimatingDepthLen, i*colLen + j);
+                }// end column indices for-loop
+            }// end row indices for-loop
+        }// end if-else
+        
+        decimatingDepthLen /= 2; //OR: decimatingDepthLen >>= 1;
+        decimatingRowLen /= 2; //OR: decimatingRowLen >>= 1;
+        decimatingColLen /= 2; //OR: decimatingColLen >>= 1;
+    }// end while-loop
+}// end waveletTransform3D()
 
-        //2) Then, perform 1D IDWT row-wise, left to right
-        for(unsigned int i = 0; i < runningRowLen; i++) //row indices for-loop
+// 3D Haar IDWT: each level reverts the depth-wise DWT and then performs the 2D IDWT on every slice.
+// rearrangeMode and the size limits are as for waveletTransform3D()
+void invWaveletTransform3D(unsigned char* arr, unsigned int depthLen, unsigned int rowLen, unsigned int colLen, unsigned short level, unsigned char rearrangeMode)
+{
+    std::cout << "This is level " << level << " 3D IDWT Computation." << std::endl << std::endl;
+    unsigned int runningDepthLen, runningRowLen, runningColLen;
+    unsigned long sliceLen = (unsigned long)rowLen*colLen; // the index offset between slices
+    
+    runningDepthLen = 2*depthLen/(1 << level); // initial depth running length deduced
+    runningRowLen = 2*rowLen/(1 << level); // initial row running length deduced
+    runningColLen = 2*colLen/(1 << level); // initial column running length deduced
+    
+    while(level--)
+    {
+        //1) Perform 1D IDWT depth-wise, front to back
+        if(rearrangeMode == REARRANGE_TILED)
+        {
+            revertRearrange3DFromFB(arr, rowLen, colLen, runningDepthLen, runningRowLen, runningColLen);
+        }
+        else // REARRANGE_IN_PLACE: a z-pencil is a column whose column length is sliceLen
+        {
+            for(unsigned int i = 0; i < runningRowLen; i++) //row indices for-loop
+            {
+                for(unsigned int j = 0; j < runningColLen; j++) //column indices for-loop
+                {
+                    revertRearrange2DFromTC(arr, depthLen, (unsigned int)sliceLen, runningDepthLen, i*colLen + j);
+                }// end column indices for-loop
+            }// end row indices for-loop
+        }// end if-else
+        
+        for(unsigned int z = 0; z < runningDepthLen; z+=2) // only even slice indices
         {
-            // INSTEAD USE MAPPED EQUIVALENT INDICES ONLY WHILE ASSIGNING VALUES
-            revertRearrange2DFromLR(arr, rowLen, colLen, runningColLen, i);
             unsigned char iTemp01, iTemp02;
-            for(unsigned int j = 0; j < runningColLen; j+=2) // only even column indices
+            for(unsigned int i = 0; i < runningRowLen; i++) //row indices for-loop
             {
-                    int n = i*colLen + j; // nth index (flattened) in a 2D array in the direction from left to right row-wise
-                    int v = 1; // the index offset in a 2D array in the direction from left to right row-wise
+                for(unsigned int j = 0; j < runningColLen; j++) //column indices for-loop
+                {
+                    unsigned long n = z*sliceLen + i*colLen + j; // nth index (flattened) in a 3D array in the direction from front to back depth-wise
+                    unsigned long v = sliceLen; // the index offset in a 3D array in the direction from front to back depth-wise
                     iTemp01 = *(arr + n); iTemp02 = *(arr + n + v);
                     *(arr + n) = (int)(((iTemp01 + iTemp02)/SQRT_2) + 0.5); // calculate sample to the nearest int
                     *(arr + n + v) = (int)(((iTemp01 - iTemp02)/SQRT_2) + 0.5); // calculate next sample to the nearest int
-            }// //end column indices for-loop
-        }//end row indices for-loop
+                }// end column indices for-loop
+            }// end row indices for-loop
+        }// end slice indices for-loop
+        
+        //2) Then, perform 2D IDWT slice by slice
+        for(unsigned int z = 0; z < runningDepthLen; z++) //slice indices for-loop
+        {
+            idwtLevel2D(arr + z*sliceLen, rowLen, colLen, runningRowLen, runningColLen);
+        }// end slice indices for-loop
+        
+        runningDepthLen *=2; // OR: runningDepthLen <<= 1;
         runningRowLen *=2; // OR: runningRowLen <<= 1;
         runningColLen *=2; // OR: runningColLen <<= 1;
     }// end while-loop
-}// end invWaveletTransform2D()
+}// end invWaveletTransform3D()
+
+//E. re-arrange starting from front to back along depth (depth-wise): trends (even slices) to the front
+// half and fluctuations (odd slices) to the back half of the decimating region. The region is cut into
+// tiles of whole or partial rows of at most Z_TILE_LEN values; each permutation cycle is followed once
+// per tile, moving the tile contiguously from slice to slice, with the tile in flight in a scratch array.
+// All lengths being dyadic, the tiles cover the region exactly
+void rearrange3DFromFB(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned int decimatingDepthLen, unsigned int decimatingRowLen, unsigned int decimatingColLen)
+{
+    unsigned long sliceLen = (unsigned long)rowLen*colLen; // the index offset between slices
+    unsigned int halfLen = decimatingDepthLen/2;
+    unsigned int tileColLen = (decimatingColLen < Z_TILE_LEN) ? decimatingColLen : Z_TILE_LEN; // columns per tile
+    unsigned int tileRowLen = Z_TILE_LEN/tileColLen; // rows per tile
+    if(tileRowLen > decimatingRowLen) tileRowLen = decimatingRowLen;
+    unsigned char tile[Z_TILE_LEN]; // the values in flight while a cycle is followed
+    unsigned char indexMask[decimatingDepthLen]; // non-zero once a slice has been moved into place
+    
+    for(unsigned int i0 = 0; i0 < decimatingRowLen; i0 += tileRowLen) // tile row indices for-loop
+    {
+        for(unsigned int j0 = 0; j0 < decimatingColLen; j0 += tileColLen) // tile column indices for-loop
+        {
+            for(unsigned int k = 0; k < decimatingDepthLen; k++)
+            {
+                indexMask[k] = 0;
+            }// end for
+            
+            // slices 0 and decimatingDepthLen - 1 never move
+            for(unsigned int z = 1; z + 1 < decimatingDepthLen; z++) //slice indices for-loop
+            {
+                if(indexMask[z]) continue; // already moved as part of an earlier cycle
+                
+                // save the tile of slice z: its place is the first to be overwritten
+                for(unsigned int i = 0; i < tileRowLen; i++)
+                {
+                    const unsigned char* pSrc = arr + z*sliceLen + (unsigned long)(i0 + i)*colLen + j0;
+                    for(unsigned int j = 0; j < tileColLen; j++)
+                    {
+                        tile[i*tileColLen + j] = *(pSrc + j);
+                    }// end column indices for-loop
+                }// end row indices for-loop
+                
+                //FILL EACH SLICE OF THE CYCLE FROM THE SLICE WHOSE VALUES BELONG THERE UNTIL WE RETURN TO SLICE z
+                unsigned int zDst = z;
+                while(1)
+                {
+                    // the front half receives the old even slices and the back half the old odd slices
+                    unsigned int zSrc = (zDst < halfLen) ? 2*zDst : 2*(zDst - halfLen) + 1;
+                    indexMask[zDst] = 1;
+                    for(unsigned int i = 0; i < tileRowLen; i++)
+                    {
+                        unsigned char* pDst = arr + zDst*sliceLen + (unsigned long)(i0 + i)*colLen + j0;
+                        const unsigned char* pSrc = (zSrc == z) ? (tile + i*tileColLen) : (arr + zSrc*sliceLen + (unsigned long)(i0 + i)*colLen + j0);
+                        for(unsigned int j = 0; j < tileColLen; j++)
+                        {
+                            *(pDst + j) = *(pSrc + j);
+                        }// end column indices for-loop
+                    }// end row indices for-loop
+                    if(zSrc == z) break; // cycle closed
+                    zDst = zSrc;
+                }// end while
+            }// end slice indices for-loop
+        }// end tile column indices for-loop
+    }// end tile row indices for-loop
+}// end rearrange3DFromFB()
+
+//EE. revert re-arrangement starting from front to back along depth (depth-wise): the front half of the
+// running region goes back to the even slices and the back half to the odd slices, a tile at a time
+void revertRearrange3DFromFB(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned int runningDepthLen, unsigned int runningRowLen, unsigned int runningColLen)
+{
+    unsigned long sliceLen = (unsigned long)rowLen*colLen; // the index offset between slices
+    unsigned int halfLen = runningDepthLen/2;
+    unsigned int tileColLen = (runningColLen < Z_TILE_LEN) ? runningColLen : Z_TILE_LEN; // columns per tile
+    unsigned int tileRowLen = Z_TILE_LEN/tileColLen; // rows per tile
+    if(tileRowLen > runningRowLen) tileRowLen = runningRowLen;
+    unsigned char tile[Z_TILE_LEN]; // the values in flight while a cycle is followed
+    unsigned char indexMask[runningDepthLen]; // non-zero once a slice has been moved into place
+    
+    for(unsigned int i0 = 0; i0 < runningRowLen; i0 += tileRowLen) // tile row indices for-loop
+    {
+        for(unsigned int j0 = 0; j0 < runningColLen; j0 += tileColLen) // tile column indices for-loop
+        {
+            for(unsigned int k = 0; k < runningDepthLen; k++)
+            {
+                indexMask[k] = 0;
+            }// end for
+            
+            // slices 0 and runningDepthLen - 1 never move
+            for(unsigned int z = 1; z + 1 < runningDepthLen; z++) //slice indices for-loop
+            {
+                if(indexMask[z]) continue; // already moved as part of an earlier cycle
+                
+                // save the tile of slice z: its place is the first to be overwritten
+                for(unsigned int i = 0; i < tileRowLen; i++)
+                {
+                    const unsigned char* pSrc = arr + z*sliceLen + (unsigned long)(i0 + i)*colLen + j0;
+                    for(unsigned int j = 0; j < tileColLen; j++)
+                    {
+                        tile[i*tileColLen + j] = *(pSrc + j);
+                    }// end column indices for-loop
+                }// end row indices for-loop
+                
+                //FILL EACH SLICE OF THE CYCLE FROM THE SLICE WHOSE VALUES BELONG THERE UNTIL WE RETURN TO SLICE z
+                unsigned int zDst = z;
+                while(1)
+                {
+                    // the even slices receive the front half and the odd slices the back half
+                    unsigned int zSrc = ((zDst % 2) == 0) ? zDst/2 : halfLen + zDst/2;
+                    indexMask[zDst] = 1;
+                    for(unsigned int i = 0; i < tileRowLen; i++)
+                    {
+                        unsigned char* pDst = arr + zDst*sliceLen + (unsigned long)(i0 + i)*colLen + j0;
+                        const unsigned char* pSrc = (zSrc == z) ? (tile + i*tileColLen) : (arr + zSrc*sliceLen + (unsigned long)(i0 + i)*colLen + j0);
+                        for(unsigned int j = 0; j < tileColLen; j++)
+                        {
+                            *(pDst + j) = *(pSrc + j);
+                        }// end column indices for-loop
+                    }// end row indices for-loop
+                    if(zSrc == z) break; // cycle closed
+                    zDst = zSrc;
+                }// end while
+            }// end slice indices for-loop
+        }// end tile column indices for-loop
+    }// end tile row indices for-loop
+}// end revertRearrange3DFromFB()
+
+// 3D DWT and IDWT of a depthLen-slice volume made by panning image (slice z is image shifted left by z
+// columns), once with each re-arrangement mode: REARRANGE_TILED must give the same DWT and IDWT as
+// REARRANGE_IN_PLACE. Returns the number of mismatching values
+unsigned long checkTransform3D(const unsigned char* image, unsigned int rowLen, unsigned int colLen, unsigned int depthLen, unsigned short level)
+{
+    unsigned long sliceLen = (unsigned long)rowLen*colLen;
+    unsigned long len = depthLen*sliceLen;
+    unsigned long mismatches = 0;
+    unsigned char* volInPlace = new unsigned char[len];
+    unsigned char* volTiled = new unsigned char[len];
+    
+    for(unsigned int z = 0; z < depthLen; z++) //slice indices for-loop
+    {
+        for(unsigned int i = 0; i < rowLen; i++) //row indices for-loop
+        {
+            for(unsigned int j = 0; j < colLen; j++) //column indices for-loop
+            {
+                unsigned long n = z*sliceLen + i*colLen + j;
+                *(volInPlace + n) = *(image + i*colLen + (j + z) % colLen);
+                *(volTiled + n) = *(volInPlace + n);
+            }// end column indices for-loop
+        }// end row indices for-loop
+    }// end slice indices for-loop
+    
+    waveletTransform3D(volInPlace, depthLen, rowLen, colLen, level, REARRANGE_IN_PLACE);
+    waveletTransform3D(volTiled, depthLen, rowLen, colLen, level, REARRANGE_TILED);
+    for(unsigned long n = 0; n < len; n++)
+    {
+        mismatches += (*(volInPlace + n) != *(volTiled + n));
+    }// end for
+    
+    invWaveletTransform3D(volInPlace, depthLen, rowLen, colLen, level, REARRANGE_IN_PLACE);
+    invWaveletTransform3D(volTiled, depthLen, rowLen, colLen, level, REARRANGE_TILED);
+    for(unsigned long n = 0; n < len; n++)
+    {
+        mismatches += (*(volInPlace + n) != *(volTiled + n));
+    }// end for
+    
+    delete [] volTiled;
+    delete [] volInPlace;
+    return mismatches;
+}// end checkTransform3D()
 
 //A. re-arrange starting from left to right along row (row-wise)
 void rearrange2DFromLR(unsigned char* arr, unsigned int rowLen, unsigned int colLen, unsigned int decimatingColLen, unsigned int decimatingRowIndex)